@@ -15,27 +15,18 @@
 #include "TGaxis.h"
 #include "TCutG.h"
 
-using namespace std;
-auto background(double *x, double *par) {
-    double func=par[0]*x[0]*x[0]*x[0]*x[0]+par[1]*x[0]*x[0]*x[0]+par[2]*x[0]*x[0]+par[3]*x[0]+par[4];
-    if(func>0)
-      return func;
-    else
-        return 0.0;
-    }
-
-auto gauss(double *x, double *par){
-        return par[0]*TMath::Gaus(x[0],par[1],par[2]);
-    }
-
-auto signal(double *x, double *par) {
-      return gauss(x, par);
-    }
+#include "lambdaMassFit.h"
 
-auto combined(double* x, double* par){
-        return background(x,par) + signal(x,&par[5]);
-    }
+using namespace std;
+using namespace lambdamassfit;
 
+// fits one hMassLambdaPt histogram and extracts the Lambda yield
+LambdaFit fitLambdaMass(TH1F* histogram, const char* fitOption="MER0"){
+    LambdaFit fit = extractLambdaYield(histogram, newCombined(), fitOption);
+    fit.backgroundFunction->SetLineColor(kGreen);
+    fit.fitFunction->SetLineColor(kBlue);
+    return fit;
+}
 
 void analysis(){
     TFile* inFile = new TFile("results/step0/AnalysisResults.root"); //getting the root file
@@ -67,38 +58,12 @@ void analysis(){
 
 
     for (size_t i = 0; i < histograms.size(); i++ ){
-        histograms[i]->GetXaxis()->SetRangeUser(1.05, 1.2);
-        TF1* fittedMass=new TF1("signal and background fitted", combined, 1.05, 1.2, 8);
-        fittedMass->SetParameters(0, 0, 0, 0, 0, 3000, 1.115, -2.22915e-03);
-        histograms[i]->Fit(fittedMass, "MER0");
-        double* fparsMass = fittedMass -> GetParameters();
-        TF1* backgroundFromFitMass=new TF1("signal and background fitted", background, 1.05, 1.2, 5); //separating function of background and signal after fitting
-        backgroundFromFitMass->SetParameters(fparsMass[0], fparsMass[1], fparsMass[2], fparsMass[3], fparsMass[4]);
-        TF1* signalFromFitMass=new TF1("signal and background fitted", signal, 1.05, 1.2, 3);
-        signalFromFitMass->SetParameters(fparsMass[5], fparsMass[6], fparsMass[7]);
-        backgroundFromFitMass->SetLineColor(kGreen);
-        fittedMass->SetLineColor(kBlue);
-        masses.push_back(fittedMass);
-        signals.push_back(signalFromFitMass);
-        backgrounds.push_back(backgroundFromFitMass);
-        
-        float integral=0;
-        float minus=0;
-        for (int j=0; j<histograms[i]->GetNbinsX(); j++){
-            
-            
-            if(signalFromFitMass->Eval(histograms[i]->GetBinCenter(j))>1)
-            {
-               integral+=signalFromFitMass->Eval(histograms[i]->GetBinCenter(j));
-                minus+=backgroundFromFitMass->Eval(histograms[i]->GetBinCenter(j));
-            
-            }
-      
-            
-        }
-        integrals.push_back(integral-minus);
-     
-        mi.push_back(minus);
+        LambdaFit fit = fitLambdaMass(histograms[i]);
+        masses.push_back(fit.fitFunction);
+        signals.push_back(fit.signalFunction);
+        backgrounds.push_back(fit.backgroundFunction);
+        integrals.push_back(fit.yield());
+        mi.push_back(fit.backgroundSum);
     }
     float pt=0.5;
     TGraphErrors* hLambdaFromPt =new TGraphErrors();
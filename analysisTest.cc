@@ -0,0 +1,95 @@
+// Regression and throughput suite for the Lambda mass fits of analysis.cc.
+//
+//   root -l -b -q 'analysisTest.cc(5, 0.5)'
+//
+// Synthetic spectra are generated in the hMassLambdaPt layout (200 bins in
+// 1.05-1.5 GeV/c^2), a Gaussian Lambda peak on a polynomial background, for
+// several statistics and signal/background ratios. Each one goes through
+// fitLambdaMass() exactly as analysis() calls it, and fit.yield(), the value
+// analysis() plots and the step0 monitor writes, is compared to the number of
+// generated signal entries. The macro prints fits per second and the
+// convergence rate and returns the number of failed checks.
+
+#include "TRandom.h"
+#include "TStopwatch.h"
+
+#include "analysis.cc"
+
+int analysisTest(int replicas = 5, double minConvergence = 0.5){
+    const double massLambda = 1.115683;
+    const double widthLambda = 0.0025;
+    const vector<int> signalCounts = {2000, 20000, 200000};
+    const vector<double> signalToBackground = {0.2, 1., 5.}; // within the fit range 1.05-1.2
+
+    TF1* backgroundShape = new TF1("backgroundShape", "1 + 6*(x-1.05) - 8*(x-1.05)*(x-1.05)", 1.05, 1.5);
+    const double backgroundFull = backgroundShape->Integral(1.05, 1.5);
+    const double backgroundFit = backgroundShape->Integral(1.05, 1.2);
+
+    gRandom->SetSeed(4242);
+    TStopwatch fitTimer;
+    fitTimer.Reset();
+    int nFits=0, nConverged=0, nFailed=0;
+
+    printf("%10s %6s %10s %12s %12s %8s\n", "signal", "S/B", "converged", "mean yield", "generated", "failed");
+    for (int nSignal : signalCounts){
+        for (double sb : signalToBackground){
+            const int nBackground = TMath::Nint(nSignal / sb * backgroundFull / backgroundFit);
+            int converged=0, failed=0;
+            double sumYield=0, sumGenerated=0;
+            for (int r=0; r<replicas; r++){
+                const TString name = TString::Format("hMassLambdaPtTest_%d_%g_%d", nSignal, sb, r);
+                // signal and background are generated into their own histograms,
+                // the signal one gives the truth, their sum is fitted
+                TH1F* hSignal = new TH1F(name+"_signal", "", 200, 1.05, 1.5);
+                TH1F* hBackground = new TH1F(name+"_background", "", 200, 1.05, 1.5);
+                for (int k=0; k<nSignal; k++)
+                    hSignal->Fill(gRandom->Gaus(massLambda, widthLambda));
+                hBackground->FillRandom(backgroundShape, nBackground);
+                TH1F* h = (TH1F*)hSignal->Clone(name);
+                h->Add(hBackground);
+
+                fitTimer.Start(false);
+                LambdaFit fit = fitLambdaMass(h);
+                fitTimer.Stop();
+                nFits++;
+
+                // all generated signal in the histogram range, independent of the
+                // bins the extraction sums over; the statistical scale is set by
+                // the entries within +-3 sigma of the generated peak
+                const double generated = hSignal->Integral(1, hSignal->GetNbinsX());
+                const int peakLow = h->FindBin(massLambda-3*widthLambda);
+                const int peakHigh = h->FindBin(massLambda+3*widthLambda);
+                const double underPeak = hSignal->Integral(peakLow, peakHigh)+hBackground->Integral(peakLow, peakHigh);
+                const double tolerance = TMath::Max(5*TMath::Sqrt(underPeak), 0.05*generated);
+
+                if (fit.status==0){
+                    converged++;
+                    sumYield+=fit.yield();
+                    sumGenerated+=generated;
+                    if (TMath::Abs(fit.yield()-generated)>tolerance)
+                        failed++;
+                }
+                delete fit.fitFunction;
+                delete fit.backgroundFunction;
+                delete fit.signalFunction;
+                delete h;
+                delete hSignal;
+                delete hBackground;
+            }
+            nConverged+=converged;
+            nFailed+=failed;
+            printf("%10d %6.1f %6d/%-3d %12.1f %12.1f %8d\n", nSignal, sb, converged, replicas,
+                   converged ? sumYield/converged : 0., converged ? sumGenerated/converged : 0., failed);
+        }
+    }
+
+    const double convergence = nFits ? double(nConverged)/nFits : 0.;
+    printf("%d fits, %.1f fits/s (cpu %.1f fits/s), convergence rate %.3f, %d yield checks failed\n",
+           nFits, nFits/fitTimer.RealTime(), nFits/fitTimer.CpuTime(), convergence, nFailed);
+    if (convergence<minConvergence){
+        printf("convergence rate below %.3f\n", minConvergence);
+        nFailed++;
+    }
+    delete backgroundShape;
+    return nFailed;
+}
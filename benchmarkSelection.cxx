@@ -0,0 +1,364 @@
+// Standalone micro-benchmark of the Lambda selection and histogram-fill loops
+// of strangeness_step0::process and qaPlots::analysisReco.
+//
+// Needs neither O2 nor ROOT:
+//   g++ -O2 -std=c++17 -Wall -Wextra -o benchmarkSelection benchmarkSelection.cxx
+//   ./benchmarkSelection [nCollisions] [nRepeats] [ConfNsigmaTPCParticle]
+//
+// Synthetic collision/V0/daughter columns are generated once and then the
+// selection is run over them per collision, as the tasks do for each grouped
+// slice. The framework Filters (sel8, z-vertex, DCA prefilter) are evaluated by
+// DPL before the loop, so they are applied while generating the columns and
+// are not timed. HistogramRegistry is replaced by a fixed-bin stand-in with the
+// same fill cost profile (one bin lookup and one add per fill).
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "strangenessSelection.h"
+
+static std::size_t gAllocations = 0;
+
+// all replaced operators are kept out of line, otherwise GCC 12 sees malloc()
+// and free() behind operator new/delete and warns -Wmismatched-new-delete
+[[gnu::noinline]] void* operator new(std::size_t size)
+{
+  ++gAllocations;
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace
+{
+
+constexpr float massLambda = 1.115683f;
+constexpr float ctauLambda = 7.89f; // cm
+
+struct Hist1D {
+  Hist1D(int n, double lo, double hi) : nBins(n), low(lo), high(hi), counts(n + 2, 0.) {}
+
+  int findBin(double x) const
+  {
+    if (x < low)
+      return 0;
+    if (x >= high)
+      return nBins + 1;
+    return 1 + static_cast<int>((x - low) / (high - low) * nBins);
+  }
+
+  void fill(double x) { counts[findBin(x)] += 1.; }
+
+  int nBins;
+  double low, high;
+  std::vector<double> counts;
+};
+
+struct Hist2D {
+  Hist2D(int nx, double xlo, double xhi, int ny, double ylo, double yhi) : x(nx, xlo, xhi), y(ny, ylo, yhi), counts((nx + 2) * (ny + 2), 0.) {}
+
+  void fill(double vx, double vy) { counts[x.findBin(vx) + (x.nBins + 2) * y.findBin(vy)] += 1.; }
+
+  Hist1D x, y;
+  std::vector<double> counts;
+};
+
+// columns as the tasks see them after the framework Filters
+struct SyntheticData {
+  std::vector<float> colPosX, colPosY, colPosZ;
+  std::vector<int> v0Offset; // first V0 of each collision, size nCollisions + 1
+
+  std::vector<float> x, y, z, px, py, pz;
+  std::vector<float> mLambda, mAntiLambda;
+  // rows of the positive and negative daughter in the daughter columns below,
+  // as posTrackId/negTrackId or the femto childrenIds column
+  std::vector<std::array<int, 2>> childrenIds;
+
+  // daughter tracks, shuffled within each collision so that the lookups jump
+  // around the table as they do in the track table
+  std::vector<float> dauInnerParam, dauNSigmaPr, dauNSigmaPi;
+};
+
+SyntheticData generate(int nCollisions, unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::normal_distribution<float> gaus(0.f, 1.f);
+  std::uniform_real_distribution<float> flat(0.f, 1.f);
+  std::poisson_distribution<int> nV0s(25);
+  std::exponential_distribution<float> ptSpectrum(1.f / 0.9f);
+
+  SyntheticData d;
+  d.v0Offset.push_back(0);
+  for (int iCol = 0; iCol < nCollisions; iCol++) {
+    float vz;
+    do {
+      vz = 6.f * gaus(rng);
+    } while (std::abs(vz) > 10.f);
+    const float vx = 0.005f * gaus(rng);
+    const float vy = 0.005f * gaus(rng);
+    d.colPosX.push_back(vx);
+    d.colPosY.push_back(vy);
+    d.colPosZ.push_back(vz);
+
+    const int n = nV0s(rng);
+    for (int i = 0; i < n; i++) {
+      const bool isSignal = flat(rng) < 0.3f;
+      const float pt = 0.1f + ptSpectrum(rng);
+      const float eta = 1.8f * flat(rng) - 0.9f;
+      const float phi = 6.2831853f * flat(rng);
+      const float pzv = pt * std::sinh(eta);
+      const float p = std::sqrt(pt * pt + pzv * pzv);
+
+      // decay length from the Lambda lifetime for signal, combinatorial
+      // candidates spread over the inner tracker
+      const float length = isSignal ? -std::log(1.f - flat(rng)) * ctauLambda * p / massLambda : 40.f * flat(rng);
+      // combinatorial candidates do not point back to the primary vertex
+      const float smear = isSignal ? 0.01f : 0.4f;
+      const float dirX = pt * std::cos(phi) / p + smear * gaus(rng);
+      const float dirY = pt * std::sin(phi) / p + smear * gaus(rng);
+      const float dirZ = pzv / p + smear * gaus(rng);
+
+      d.x.push_back(vx + length * dirX);
+      d.y.push_back(vy + length * dirY);
+      d.z.push_back(vz + length * dirZ);
+      d.px.push_back(pt * std::cos(phi));
+      d.py.push_back(pt * std::sin(phi));
+      d.pz.push_back(pzv);
+
+      d.mLambda.push_back(isSignal ? massLambda + 0.002f * gaus(rng) : 1.08f + 0.42f * flat(rng));
+      d.mAntiLambda.push_back(1.08f + 0.42f * flat(rng));
+
+      const int firstDaughter = static_cast<int>(d.dauInnerParam.size());
+      d.childrenIds.push_back({firstDaughter, firstDaughter + 1});
+      const float pidWidth = isSignal ? 1.f : 3.f;
+      d.dauInnerParam.push_back(0.8f * p * (0.9f + 0.2f * flat(rng)));
+      d.dauNSigmaPr.push_back(pidWidth * gaus(rng));
+      d.dauNSigmaPi.push_back(pidWidth * gaus(rng) + 2.f);
+      d.dauInnerParam.push_back(0.2f * p * (0.9f + 0.2f * flat(rng)));
+      d.dauNSigmaPr.push_back(pidWidth * gaus(rng) - 2.f);
+      d.dauNSigmaPi.push_back(pidWidth * gaus(rng));
+    }
+    d.v0Offset.push_back(static_cast<int>(d.x.size()));
+
+    // shuffle the daughters of this collision and remap the children indices
+    const int firstDaughter = 2 * d.v0Offset[iCol];
+    const int nDaughters = 2 * n;
+    std::vector<int> newRow(nDaughters);
+    for (int k = 0; k < nDaughters; k++)
+      newRow[k] = firstDaughter + k;
+    std::shuffle(newRow.begin(), newRow.end(), rng);
+    for (auto* column : {&d.dauInnerParam, &d.dauNSigmaPr, &d.dauNSigmaPi}) {
+      std::vector<float> shuffled(nDaughters);
+      for (int k = 0; k < nDaughters; k++)
+        shuffled[newRow[k] - firstDaughter] = (*column)[firstDaughter + k];
+      std::copy(shuffled.begin(), shuffled.end(), column->begin() + firstDaughter);
+    }
+    for (int i = d.v0Offset[iCol]; i < d.v0Offset[iCol + 1]; i++) {
+      for (int& child : d.childrenIds[i])
+        child = newRow[child - firstDaughter];
+    }
+  }
+  return d;
+}
+
+// same definitions as the dynamic columns of aod::V0Datas
+inline float v0cosPA(const SyntheticData& d, int i, float pvX, float pvY, float pvZ)
+{
+  const float dx = d.x[i] - pvX;
+  const float dy = d.y[i] - pvY;
+  const float dz = d.z[i] - pvZ;
+  const float dot = dx * d.px[i] + dy * d.py[i] + dz * d.pz[i];
+  return dot / std::sqrt((dx * dx + dy * dy + dz * dz) * (d.px[i] * d.px[i] + d.py[i] * d.py[i] + d.pz[i] * d.pz[i]));
+}
+
+inline float v0radius(const SyntheticData& d, int i)
+{
+  return std::hypot(d.x[i], d.y[i]);
+}
+
+struct Step0Histos {
+  Hist1D hVertexZRec{100, -15., 15.};
+  Hist1D hMassLambda{200, 1.05, 1.5};
+  Hist2D hNSigmaPosProtonFromLambda{100, 0., 10., 100, -5., 5.};
+  Hist2D hNSigmaNegPionFromLambda{100, 0., 10., 100, -5., 5.};
+  Hist1D hPtLambda{100, 0., 10.};
+  Hist2D hMassPtLambda{100, 0., 10., 200, 1.05, 1.5};
+  std::vector<Hist1D> hMassLambdaPt = std::vector<Hist1D>(strangeness::nLambdaPtBins, Hist1D{200, 1.05, 1.5});
+};
+
+// mirrors strangeness_step0::process with its default configurables
+long runStep0(const SyntheticData& d, Step0Histos& h, strangeness::V0TopologyBuffer& v0Topology)
+{
+  long selected = 0;
+  const int nCollisions = static_cast<int>(d.colPosZ.size());
+  for (int iCol = 0; iCol < nCollisions; iCol++) {
+    h.hVertexZRec.fill(d.colPosZ[iCol]);
+    const int first = d.v0Offset[iCol];
+    const int n = d.v0Offset[iCol + 1] - first;
+    // same gather as the tasks, which cannot hand the filtered V0 slice to the
+    // kernel as contiguous arrays
+    v0Topology.clear();
+    for (int i = first; i < first + n; i++) {
+      v0Topology.push(d.x[i], d.y[i], d.z[i], d.px[i], d.py[i], d.pz[i]);
+    }
+    v0Topology.select(d.colPosX[iCol], d.colPosY[iCol], d.colPosZ[iCol], 0.97, 0.5f);
+    for (int k = 0; k < n; k++) {
+      if (!v0Topology.selected[k])
+        continue;
+      const int i = first + k;
+      // v0.posTrack_as<>() and v0.negTrack_as<>()
+      const int pos = d.childrenIds[i][0];
+      const int neg = d.childrenIds[i][1];
+      if (!strangeness::passesDaughterPID(d.dauNSigmaPr[pos], d.dauNSigmaPi[neg], 4.f, 4.f))
+        continue;
+
+      h.hMassLambda.fill(d.mLambda[i]);
+      h.hNSigmaPosProtonFromLambda.fill(d.dauInnerParam[pos], d.dauNSigmaPr[pos]);
+      h.hNSigmaNegPionFromLambda.fill(d.dauInnerParam[neg], d.dauNSigmaPi[neg]);
+
+      if (!strangeness::passesDaughterMomentum(d.dauInnerParam[pos], d.dauInnerParam[neg]))
+        continue;
+
+      const float pt = std::hypot(d.px[i], d.py[i]);
+      h.hPtLambda.fill(pt);
+      h.hMassPtLambda.fill(pt, d.mLambda[i]);
+      const int ptBin = strangeness::lambdaPtBin(pt);
+      if (ptBin >= 0)
+        h.hMassLambdaPt[ptBin].fill(d.mLambda[i]);
+      selected++;
+    }
+  }
+  return selected;
+}
+
+// per-row cosPA and radius, as strangeness_step0::process did before the
+// batched topology selection
+long runStep0PerRow(const SyntheticData& d, Step0Histos& h)
+{
+  long selected = 0;
+  const int nCollisions = static_cast<int>(d.colPosZ.size());
+  for (int iCol = 0; iCol < nCollisions; iCol++) {
+    h.hVertexZRec.fill(d.colPosZ[iCol]);
+    for (int i = d.v0Offset[iCol]; i < d.v0Offset[iCol + 1]; i++) {
+      if (!strangeness::passesTopology(v0cosPA(d, i, d.colPosX[iCol], d.colPosY[iCol], d.colPosZ[iCol]), v0radius(d, i), 0.97, 0.5f))
+        continue;
+      // v0.posTrack_as<>() and v0.negTrack_as<>()
+      const int pos = d.childrenIds[i][0];
+      const int neg = d.childrenIds[i][1];
+      if (!strangeness::passesDaughterPID(d.dauNSigmaPr[pos], d.dauNSigmaPi[neg], 4.f, 4.f))
+        continue;
+
+      h.hMassLambda.fill(d.mLambda[i]);
+      h.hNSigmaPosProtonFromLambda.fill(d.dauInnerParam[pos], d.dauNSigmaPr[pos]);
+      h.hNSigmaNegPionFromLambda.fill(d.dauInnerParam[neg], d.dauNSigmaPi[neg]);
+
+      if (!strangeness::passesDaughterMomentum(d.dauInnerParam[pos], d.dauInnerParam[neg]))
+        continue;
+
+      const float pt = std::hypot(d.px[i], d.py[i]);
+      h.hPtLambda.fill(pt);
+      h.hMassPtLambda.fill(pt, d.mLambda[i]);
+      const int ptBin = strangeness::lambdaPtBin(pt);
+      if (ptBin >= 0)
+        h.hMassLambdaPt[ptBin].fill(d.mLambda[i]);
+      selected++;
+    }
+  }
+  return selected;
+}
+
+struct QaHistos {
+  // per accepted V0 analysisReco fills 4 TH1 and 3 TH2 for each daughter and
+  // 7 TH1 and 1 TH2 for the V0 itself
+  std::vector<Hist1D> h1 = std::vector<Hist1D>(15, Hist1D{200, -4.975, 5.025});
+  std::vector<Hist2D> h2 = std::vector<Hist2D>(7, Hist2D{100, 0., 10., 200, -4.975, 5.025});
+};
+
+// qaPlots::IsNSigmaTPC
+inline bool isNSigmaTPC(float nSigmaTPCParticle, float confNsigmaTPCParticle)
+{
+  return std::abs(nSigmaTPCParticle) < confNsigmaTPCParticle;
+}
+
+// mirrors the V0 loop of qaPlots::analysisReco for ConfisLambda, with
+// confNsigmaTPCParticle standing for the ConfNsigmaTPCParticle configurable
+long runQaPlots(const SyntheticData& d, QaHistos& h, float confNsigmaTPCParticle)
+{
+  long selected = 0;
+  const int nCollisions = static_cast<int>(d.colPosZ.size());
+  for (int iCol = 0; iCol < nCollisions; iCol++) {
+    for (int i = d.v0Offset[iCol]; i < d.v0Offset[iCol + 1]; i++) {
+      if (!strangeness::inLambdaMassWindow(d.mLambda[i], d.mAntiLambda[i], 1.111f, 1.119f))
+        continue;
+      // parts.iteratorAt(childrenIds[0]) and parts.iteratorAt(childrenIds[1])
+      const auto& childrenIds = d.childrenIds[i];
+      const int posChild = childrenIds[0];
+      const int negChild = childrenIds[1];
+      if (!isNSigmaTPC(d.dauNSigmaPr[posChild], confNsigmaTPCParticle) || !isNSigmaTPC(d.dauNSigmaPi[negChild], confNsigmaTPCParticle))
+        continue;
+
+      const float pt = std::hypot(d.px[i], d.py[i]);
+      for (int j = 0; j < 3; j++) {
+        h.h2[j].fill(d.dauInnerParam[posChild], d.dauNSigmaPr[posChild]);
+        h.h2[3 + j].fill(d.dauInnerParam[negChild], d.dauNSigmaPi[negChild]);
+      }
+      h.h2[6].fill(pt, d.mLambda[i]);
+      for (int j = 0; j < 4; j++) {
+        h.h1[j].fill(d.dauNSigmaPr[posChild]);
+        h.h1[4 + j].fill(d.dauNSigmaPi[negChild]);
+      }
+      for (int j = 8; j < 15; j++)
+        h.h1[j].fill(pt);
+      selected++;
+    }
+  }
+  return selected;
+}
+
+template <typename F>
+void report(const char* name, long nCandidates, int nRepeats, F&& body)
+{
+  const std::size_t allocationsBefore = gAllocations;
+  const auto start = std::chrono::steady_clock::now();
+  long selected = 0;
+  for (int iRep = 0; iRep < nRepeats; iRep++)
+    selected += body();
+  const auto stop = std::chrono::steady_clock::now();
+  const std::size_t allocations = gAllocations - allocationsBefore;
+
+  const double seconds = std::chrono::duration<double>(stop - start).count();
+  const double processed = static_cast<double>(nCandidates) * nRepeats;
+  std::printf("%-10s %12.0f cand/s %8.2f ns/cand  selected %6.2f%%  allocations %zu\n",
+              name, processed / seconds, 1e9 * seconds / processed, 100. * selected / processed, allocations);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  const int nCollisions = argc > 1 ? std::atoi(argv[1]) : 20000;
+  const int nRepeats = argc > 2 ? std::atoi(argv[2]) : 20;
+  const float confNsigmaTPCParticle = argc > 3 ? std::atof(argv[3]) : 3.f;
+
+  const SyntheticData data = generate(nCollisions, 12345);
+  const long nCandidates = static_cast<long>(data.x.size());
+  std::printf("%d collisions, %ld V0 candidates, %d repeats\n", nCollisions, nCandidates, nRepeats);
+
+  Step0Histos step0Histos;
+  strangeness::V0TopologyBuffer v0Topology;
+  QaHistos qaHistos;
+  report("step0", nCandidates, nRepeats, [&] { return runStep0(data, step0Histos, v0Topology); });
+  report("step0/row", nCandidates, nRepeats, [&] { return runStep0PerRow(data, step0Histos); });
+  report("qaPlots", nCandidates, nRepeats, [&] { return runQaPlots(data, qaHistos, confNsigmaTPCParticle); });
+  return 0;
+}
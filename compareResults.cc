@@ -0,0 +1,75 @@
+// Compares the histograms of two AnalysisResults.root files bin by bin, e.g. a
+// single-process run against one with pipelined replicas, whose histograms the
+// output sink merges by name at the end of the stream:
+//
+//   o2-analysis-... --pipeline strangeness_tutorial:1 ...   -> results/single
+//   o2-analysis-... --pipeline strangeness_tutorial:2 ...   -> results/pipeline
+//   root -l -b -q 'compareResults.cc("results/single/AnalysisResults.root", "results/pipeline/AnalysisResults.root")'
+//
+// Fills with unit weight give identical counts whichever replica a timeframe
+// went to. Returns the number of histograms that are missing or differ.
+
+#include <cstdio>
+
+#include "TFile.h"
+#include "TDirectory.h"
+#include "TKey.h"
+#include "TH1.h"
+#include "TString.h"
+
+int compareDirectory(TDirectory* reference, TDirectory* other, const TString& path){
+    int nDifferent=0;
+    TIter next(reference->GetListOfKeys());
+    while (TKey* key = (TKey*)next()){
+        const TString name = path + "/" + key->GetName();
+        TObject* object = key->ReadObj();
+        if (object->InheritsFrom(TDirectory::Class())){
+            TDirectory* otherDirectory = other->GetDirectory(key->GetName());
+            if (!otherDirectory){
+                printf("missing directory %s\n", name.Data());
+                nDifferent++;
+                continue;
+            }
+            nDifferent+=compareDirectory((TDirectory*)object, otherDirectory, name);
+            continue;
+        }
+        if (!object->InheritsFrom(TH1::Class()))
+            continue;
+        TH1* h = (TH1*)object;
+        TH1* hOther = other->Get<TH1>(key->GetName());
+        if (!hOther){
+            printf("missing histogram %s\n", name.Data());
+            nDifferent++;
+            continue;
+        }
+        if (h->GetNcells()!=hOther->GetNcells()){
+            printf("%s: %d vs %d cells\n", name.Data(), h->GetNcells(), hOther->GetNcells());
+            nDifferent++;
+            continue;
+        }
+        int nBins=0;
+        for (int j=0; j<h->GetNcells(); j++){
+            if (h->GetBinContent(j)!=hOther->GetBinContent(j))
+                nBins++;
+        }
+        if (nBins){
+            printf("%s: %d bins differ, entries %.0f vs %.0f\n", name.Data(), nBins, h->GetEntries(), hOther->GetEntries());
+            nDifferent++;
+        }
+    }
+    return nDifferent;
+}
+
+int compareResults(const char* referenceFile, const char* otherFile){
+    TFile* reference = TFile::Open(referenceFile);
+    TFile* other = TFile::Open(otherFile);
+    if (!reference || reference->IsZombie() || !other || other->IsZombie()){
+        printf("cannot open %s or %s\n", referenceFile, otherFile);
+        return 1;
+    }
+    const int nDifferent = compareDirectory(reference, other, "");
+    printf("%d histograms differ\n", nDifferent);
+    delete reference;
+    delete other;
+    return nDifferent;
+}
@@ -0,0 +1,80 @@
+#ifndef LAMBDA_MASS_FIT_H_
+#define LAMBDA_MASS_FIT_H_
+
+#include "TF1.h"
+#include "TH1.h"
+#include "TMath.h"
+
+// Lambda invariant-mass model used by analysis.cc and by the monitoring mode
+// of strangeness_step0: 4th order polynomial background plus a Gaussian peak.
+namespace lambdamassfit
+{
+
+inline double background(double *x, double *par) {
+    double func=par[0]*x[0]*x[0]*x[0]*x[0]+par[1]*x[0]*x[0]*x[0]+par[2]*x[0]*x[0]+par[3]*x[0]+par[4];
+    if(func>0)
+        return func;
+    else
+        return 0.0;
+}
+
+inline double gauss(double *x, double *par){
+    return par[0]*TMath::Gaus(x[0],par[1],par[2]);
+}
+
+inline double signal(double *x, double *par) {
+    return gauss(x, par);
+}
+
+inline double combined(double* x, double* par){
+    return background(x,par) + signal(x,&par[5]);
+}
+
+constexpr double fitLow = 1.05;
+constexpr double fitHigh = 1.2;
+constexpr int nParameters = 8;
+
+inline TF1* newCombined(){
+    TF1* fittedMass=new TF1("signal and background fitted", combined, fitLow, fitHigh, nParameters);
+    fittedMass->SetParameters(0, 0, 0, 0, 0, 3000, 1.115, -2.22915e-03);
+    return fittedMass;
+}
+
+struct LambdaFit {
+    TF1* fitFunction;
+    TF1* backgroundFunction;
+    TF1* signalFunction;
+    int status;            // return value of TH1::Fit, 0 when converged
+    float signalSum;       // signal function summed over the bins under the peak
+    float backgroundSum;   // background function summed over the same bins
+    // the signal function is the Gaussian alone, so its sum is already the
+    // background-subtracted yield
+    float yield() const { return signalSum; }
+};
+
+// fits the histogram starting from the current parameters of fittedMass and
+// extracts the Lambda yield. The caller owns the returned functions.
+inline LambdaFit extractLambdaYield(TH1* histogram, TF1* fittedMass, const char* fitOption){
+    histogram->GetXaxis()->SetRangeUser(fitLow, fitHigh);
+    int status = histogram->Fit(fittedMass, fitOption);
+    double* fparsMass = fittedMass -> GetParameters();
+    TF1* backgroundFromFitMass=new TF1("signal and background fitted", background, fitLow, fitHigh, 5); //separating function of background and signal after fitting
+    backgroundFromFitMass->SetParameters(fparsMass[0], fparsMass[1], fparsMass[2], fparsMass[3], fparsMass[4]);
+    TF1* signalFromFitMass=new TF1("signal and background fitted", signal, fitLow, fitHigh, 3);
+    signalFromFitMass->SetParameters(fparsMass[5], fparsMass[6], fparsMass[7]);
+
+    float integral=0;
+    float minus=0;
+    for (int j=0; j<histogram->GetNbinsX(); j++){
+        if(signalFromFitMass->Eval(histogram->GetBinCenter(j))>1)
+        {
+            integral+=signalFromFitMass->Eval(histogram->GetBinCenter(j));
+            minus+=backgroundFromFitMass->Eval(histogram->GetBinCenter(j));
+        }
+    }
+    return {fittedMass, backgroundFromFitMass, signalFromFitMass, status, integral, minus};
+}
+
+} // namespace lambdamassfit
+
+#endif // LAMBDA_MASS_FIT_H_
@@ -14,6 +14,8 @@
 #include "PWGCF/FemtoUniverse/Core/FemtoUtils.h"
 #include "Common/Core/RecoDecay.h"
 
+#include "strangenessSelection.h"
+
 using namespace o2;
 using namespace o2::soa;
 using namespace o2::framework;
@@ -186,10 +188,7 @@ struct qaPlots {
 
   bool invMLambda(float invMassLambda, float invMassAntiLambda)
   {
-    if ((invMassLambda < ConfV0InvMassLowLimit || invMassLambda > ConfV0InvMassUpLimit) && (invMassAntiLambda < ConfV0InvMassLowLimit || invMassAntiLambda > ConfV0InvMassUpLimit)) {
-      return false;
-    }
-    return true;
+    return strangeness::inLambdaMassWindow(invMassLambda, invMassAntiLambda, ConfV0InvMassLowLimit, ConfV0InvMassUpLimit);
   }
 
   template <typename T>
@@ -210,8 +209,11 @@ struct qaPlots {
     for (auto& part : groupPartsTwo) {
       if (!invMLambda(part.mLambda(), part.mAntiLambda()))
         continue;
-      const auto& posChild = parts.iteratorAt(part.index() - 2);
-      const auto& negChild = parts.iteratorAt(part.index() - 1);
+      // the producer stores the rows of the V0 daughters in the children index
+      // column, so the lookup does not rely on the row order of the table
+      const auto& childrenIds = part.childrenIds();
+      const auto& posChild = parts.iteratorAt(childrenIds[0]);
+      const auto& negChild = parts.iteratorAt(childrenIds[1]);
       if (!IsParticleTPC(posChild, V0ChildTable[ConfV0Type1][0]) || !IsParticleTPC(negChild, V0ChildTable[ConfV0Type1][1]))
         continue;
 
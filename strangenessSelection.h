@@ -0,0 +1,147 @@
+#ifndef STRANGENESS_SELECTION_H_
+#define STRANGENESS_SELECTION_H_
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Lambda candidate selection shared by the analysis tasks and by the standalone
+// benchmark. Kept free of O2 headers so it builds on a plain Linux box.
+namespace strangeness
+{
+
+constexpr int nLambdaPtBins = 16;
+constexpr float lambdaPtLow = 0.5f;
+constexpr float lambdaPtWidth = 0.125f;
+
+inline bool passesTopology(float cosPA, float radius, double minCosPA, float minRadius)
+{
+  if (cosPA < minCosPA)
+    return false;
+  if (radius < minRadius)
+    return false;
+  return true;
+}
+
+// at -O2 GCC does not vectorise loops with a run-time trip count (very-cheap
+// cost model), clang does. The cost model is raised for v0TopologyMask only.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC push_options
+#pragma GCC optimize("vect-cost-model=dynamic")
+#endif
+
+// Geometric selection of n V0s of one collision, the batched counterpart of
+// passesTopology(v0cosPA, v0radius, ...). cosPA >= c is tested as
+// dot >= c * |d| * |p| on squared quantities in double precision, so the loop
+// has no square root, division or branch and the cosPA decision is the one of
+// the exact cosine. A cosPA evaluated in float can land on the other side of
+// the cut for V0s within float rounding (~1e-7) of it. The radius is compared
+// as x^2 + y^2 >= r^2 in float (a double comparison stops GCC vectorising),
+// so it can differ from hypot(x, y) >= r within float rounding as well.
+inline void v0TopologyMask(int n, const float* __restrict x, const float* __restrict y, const float* __restrict z,
+                           const float* __restrict px, const float* __restrict py, const float* __restrict pz,
+                           float pvX, float pvY, float pvZ, double minCosPA, float minRadius,
+                           uint8_t* __restrict selected)
+{
+  // for c <= -1 every V0 passes (|dot| <= |d| * |p|), a larger c2 keeps it so
+  // whatever the rounding of dot * dot and norm2
+  const double c2 = minCosPA <= -1. ? 4. : minCosPA * minCosPA;
+  const uint8_t positiveCut = minCosPA > 0.;
+  const float minRadius2 = minRadius > 0.f ? minRadius * minRadius : 0.f;
+  for (int i = 0; i < n; i++) {
+    const double dx = static_cast<double>(x[i]) - pvX;
+    const double dy = static_cast<double>(y[i]) - pvY;
+    const double dz = static_cast<double>(z[i]) - pvZ;
+    const double momX = px[i];
+    const double momY = py[i];
+    const double momZ = pz[i];
+    const double dot = dx * momX + dy * momY + dz * momZ;
+    const double norm2 = (dx * dx + dy * dy + dz * dz) * (momX * momX + momY * momY + momZ * momZ);
+    const uint8_t forward = dot >= 0.;
+    const uint8_t above = dot * dot >= c2 * norm2;
+    const uint8_t below = dot * dot <= c2 * norm2;
+    // c > 0 needs a forward V0 above the cut, c <= 0 accepts any forward V0
+    // and backward ones within the cut
+    const uint8_t passCosPA = (positiveCut & forward & above) | ((positiveCut ^ 1) & (forward | below));
+    const uint8_t passRadius = x[i] * x[i] + y[i] * y[i] >= minRadius2;
+    selected[i] = passCosPA & passRadius;
+  }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC pop_options
+#endif
+
+// columns of the V0s of one collision, gathered once per slice so that the
+// geometric selection runs over contiguous arrays. Buffers keep their
+// capacity between collisions.
+struct V0TopologyBuffer {
+  std::vector<float> x, y, z, px, py, pz;
+  std::vector<uint8_t> selected;
+
+  void clear()
+  {
+    x.clear();
+    y.clear();
+    z.clear();
+    px.clear();
+    py.clear();
+    pz.clear();
+  }
+
+  void push(float vx, float vy, float vz, float vpx, float vpy, float vpz)
+  {
+    x.push_back(vx);
+    y.push_back(vy);
+    z.push_back(vz);
+    px.push_back(vpx);
+    py.push_back(vpy);
+    pz.push_back(vpz);
+  }
+
+  void select(float pvX, float pvY, float pvZ, double minCosPA, float minRadius)
+  {
+    selected.resize(x.size());
+    v0TopologyMask(static_cast<int>(x.size()), x.data(), y.data(), z.data(), px.data(), py.data(), pz.data(),
+                   pvX, pvY, pvZ, minCosPA, minRadius, selected.data());
+  }
+};
+
+inline bool passesDaughterPID(float nSigmaPosProton, float nSigmaNegPion, float maxNSigmaProton, float maxNSigmaPion)
+{
+  if (std::abs(nSigmaPosProton) > maxNSigmaProton)
+    return false;
+  if (std::abs(nSigmaNegPion) > maxNSigmaPion)
+    return false;
+  return true;
+}
+
+inline bool passesDaughterMomentum(float posInnerParam, float negInnerParam)
+{
+  return 0.3 < posInnerParam && posInnerParam < 4 && 0.16 < negInnerParam && negInnerParam < 4;
+}
+
+// index of the hMassLambdaPt histogram for this pT, -1 if outside all bins.
+// Bin edges themselves are not accepted.
+inline int lambdaPtBin(float pt)
+{
+  if (!(pt > lambdaPtLow && pt < lambdaPtLow + nLambdaPtBins * lambdaPtWidth))
+    return -1;
+  // the width is a power of two, so the subtraction and division are exact
+  const int bin = static_cast<int>((pt - lambdaPtLow) / lambdaPtWidth);
+  if (pt == lambdaPtLow + bin * lambdaPtWidth)
+    return -1;
+  return bin;
+}
+
+inline bool inLambdaMassWindow(float invMassLambda, float invMassAntiLambda, float lowLimit, float upLimit)
+{
+  if ((invMassLambda < lowLimit || invMassLambda > upLimit) && (invMassAntiLambda < lowLimit || invMassAntiLambda > upLimit)) {
+    return false;
+  }
+  return true;
+}
+
+} // namespace strangeness
+
+#endif // STRANGENESS_SELECTION_H_
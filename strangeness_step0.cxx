@@ -1,8 +1,24 @@
+#include <array>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "Framework/runDataProcessing.h"
 #include "Framework/AnalysisTask.h"
+#include "Framework/CallbackService.h"
+#include "Framework/DeviceSpec.h"
+#include "Framework/EndOfStreamContext.h"
+#include "Framework/Logger.h"
 #include "Common/DataModel/EventSelection.h"
 #include "PWGLF/DataModel/LFStrangenessTables.h"
 #include "Common/DataModel/PIDResponse.h"
+#include "Framework/StaticFor.h"
+
+#include "lambdaMassFit.h"
+#include "strangenessSelection.h"
 
 using namespace o2;
 using namespace o2::framework;
@@ -27,7 +43,25 @@ struct strangeness_tutorial {
   
   Configurable<float> NSigmaTPCPion{"NSigmaTPCPion", 4, "NSigmaTPCPion"};
   Configurable<float> NSigmaTPCProton{"NSigmaTPCProton", 4, "NSigmaTPCProton"};
-  void init(InitContext const&)
+
+  Configurable<int> monitorEveryNTF{"monitorEveryNTF", 100, "processMonitor: refit the mass histograms every N timeframes"};
+  Configurable<float> monitorMinEntries{"monitorMinEntries", 500, "processMonitor: minimum entries to fit a pT bin"};
+  Configurable<std::string> monitorOutput{"monitorOutput", "lambdaMonitor.csv", "processMonitor: output file of the fit results"};
+
+  static constexpr std::string_view hMassLambdaPt[strangeness::nLambdaPtBins] = {
+    "hMassLambdaPt1", "hMassLambdaPt2", "hMassLambdaPt3", "hMassLambdaPt4",
+    "hMassLambdaPt5", "hMassLambdaPt6", "hMassLambdaPt7", "hMassLambdaPt8",
+    "hMassLambdaPt9", "hMassLambdaPt10", "hMassLambdaPt11", "hMassLambdaPt12",
+    "hMassLambdaPt13", "hMassLambdaPt14", "hMassLambdaPt15", "hMassLambdaPt16"};
+
+  strangeness::V0TopologyBuffer v0Topology;
+
+  std::array<std::shared_ptr<TH1>, strangeness::nLambdaPtBins> monitorHistos;
+  std::vector<std::unique_ptr<TF1>> monitorFits; // one per pT bin, keeps the last minimum as starting point
+  std::ofstream monitorFile;
+  int nTimeframes = 0;
+
+  void init(InitContext& ic)
   {
     AxisSpec LambdaMassAxis = {200, 1.05f, 1.5f, "#it{M}_{inv} [GeV/#it{c}^{2}]"};
     AxisSpec vertexZAxis = {nBins, -15., 15., "vrtx_{Z} [cm]"};
@@ -57,6 +91,33 @@ struct strangeness_tutorial {
     rLambda.add("hMassLambdaPt14", "hMassLambdaPt14", {HistType::kTH1F, {LambdaMassAxis}});
     rLambda.add("hMassLambdaPt15", "hMassLambdaPt15", {HistType::kTH1F, {LambdaMassAxis}});
     rLambda.add("hMassLambdaPt16", "hMassLambdaPt16", {HistType::kTH1F, {LambdaMassAxis}});
+
+    if (doprocessMonitor) {
+      std::string fileName = monitorOutput.value;
+      const auto& device = ic.services().get<const DeviceSpec>();
+      if (device.maxInputTimeslices > 1) {
+        // one file per pipeline replica, each sees its own share of the timeframes
+        fileName = std::to_string(device.inputTimesliceId) + "_" + fileName;
+      }
+      monitorFile.open(fileName);
+      if (!monitorFile) {
+        LOGF(fatal, "processMonitor: cannot open %s", fileName.c_str());
+      }
+      monitorFile << "timeframe,time,ptLow,ptHigh,status,entries,yield,background,mean,sigma\n";
+      static_for<0, strangeness::nLambdaPtBins - 1>([&](auto i) {
+        constexpr int index = i.value;
+        monitorHistos[index] = rLambda.get<TH1>(HIST(hMassLambdaPt[index]));
+      });
+      for (int i = 0; i < strangeness::nLambdaPtBins; i++) {
+        monitorFits.emplace_back(lambdamassfit::newCombined());
+      }
+      // publish the timeframes since the last periodic refit
+      ic.services().get<CallbackService>().set<CallbackService::Id::EndOfStream>([this](EndOfStreamContext&) {
+        if (monitorEveryNTF > 0 && nTimeframes % monitorEveryNTF != 0) {
+          fitMonitorSnapshots();
+        }
+      });
+    }
   }
 
  
@@ -65,6 +126,9 @@ struct strangeness_tutorial {
   Filter preFilterV0 = (nabs(aod::v0data::dcapostopv) > v0setting_dcapostopv &&
                           nabs(aod::v0data::dcanegtopv) > v0setting_dcanegtopv &&
                           aod::v0data::dcaV0daughters < v0setting_dcav0dau);
+  // tpcInnerParam is the only TracksExtra column read, but the AOD reader
+  // loads every branch of a subscribed table, so all of TracksExtra is read
+  // and decompressed. Reading single columns needs changes in the reader.
   using DaughterTracks = soa::Join<aod::TracksIU, aod::TracksExtra, aod::pidTPCPi, aod::pidTPCPr>;
 
   void process(soa::Filtered<soa::Join<aod::Collisions, aod::EvSels>>::iterator const& collision,
@@ -73,84 +137,83 @@ struct strangeness_tutorial {
     
     rEventSelection.fill(HIST("hVertexZRec"), collision.posZ());
 
+    v0Topology.clear();
     for (const auto& v0 : V0s) {
- 
-    const auto& posDaughterTrack = v0.posTrack_as<DaughterTracks>();
-    const auto& negDaughterTrack = v0.negTrack_as<DaughterTracks>();
-    
-    if (v0.v0cosPA(collision.posX(), collision.posY(), collision.posZ()) < v0setting_cospa)
-      continue;
-    if (v0.v0radius() < v0setting_radius)
-      continue;
-    if (TMath::Abs(posDaughterTrack.tpcNSigmaPr()) > NSigmaTPCProton) {
-    continue;
+      v0Topology.push(v0.x(), v0.y(), v0.z(), v0.px(), v0.py(), v0.pz());
     }
-    if (TMath::Abs(negDaughterTrack.tpcNSigmaPi()) > NSigmaTPCPion) {
-    continue;
+    v0Topology.select(collision.posX(), collision.posY(), collision.posZ(), v0setting_cospa, v0setting_radius);
+
+    int iV0 = 0;
+    for (const auto& v0 : V0s) {
+      if (!v0Topology.selected[iV0++])
+        continue;
+
+      const auto& posDaughterTrack = v0.posTrack_as<DaughterTracks>();
+      const auto& negDaughterTrack = v0.negTrack_as<DaughterTracks>();
+
+      if (!strangeness::passesDaughterPID(posDaughterTrack.tpcNSigmaPr(), negDaughterTrack.tpcNSigmaPi(), NSigmaTPCProton, NSigmaTPCPion))
+        continue;
+
+      rLambda.fill(HIST("hMassLambda"), v0.mLambda());
+
+      rLambda.fill(HIST("hNSigmaPosProtonFromLambda"), posDaughterTrack.tpcInnerParam(), posDaughterTrack.tpcNSigmaPr());
+      rLambda.fill(HIST("hNSigmaNegPionFromLambda"), negDaughterTrack.tpcInnerParam(), negDaughterTrack.tpcNSigmaPi());
+
+      if (!strangeness::passesDaughterMomentum(posDaughterTrack.tpcInnerParam(), negDaughterTrack.tpcInnerParam()))
+        continue;
+
+      rLambda.fill(HIST("hPtLambda"), v0.pt());
+      rLambda.fill(HIST("hMassPtLambda"), v0.pt(), v0.mLambda());
+
+      const int ptBin = strangeness::lambdaPtBin(v0.pt());
+      static_for<0, strangeness::nLambdaPtBins - 1>([&](auto i) {
+        constexpr int index = i.value;
+        if (ptBin == index)
+          rLambda.fill(HIST(hMassLambdaPt[index]), v0.mLambda());
+      });
     }
+  }
+
+  // fits a snapshot of each hMassLambdaPt histogram and appends the results
+  // to monitorOutput
+  void fitMonitorSnapshots()
+  {
+    const auto now = std::time(nullptr);
+    for (int i = 0; i < strangeness::nLambdaPtBins; i++) {
+      if (monitorHistos[i]->GetEntries() < monitorMinEntries)
+        continue;
+      // fit a copy, the registry histogram keeps filling and keeps its axis range
+      std::unique_ptr<TH1> snapshot(static_cast<TH1*>(monitorHistos[i]->Clone()));
+      snapshot->SetDirectory(nullptr);
 
-    rLambda.fill(HIST("hMassLambda"), v0.mLambda());
+      TF1* model = monitorFits[i].get();
+      const std::vector<double> previous(model->GetParameters(), model->GetParameters() + model->GetNpar());
+      // no E: a Minos error scan per bin would stall the device for the
+      // timeframes in flight, and the monitor only writes central values
+      auto fit = lambdamassfit::extractLambdaYield(snapshot.get(), model, "MR0Q");
+      delete fit.backgroundFunction;
+      delete fit.signalFunction;
+      if (fit.status != 0) {
+        // do not warm-start the next snapshot from a failed minimisation
+        model->SetParameters(previous.data());
+      }
 
-    
-    rLambda.fill(HIST("hNSigmaPosProtonFromLambda"), posDaughterTrack.tpcInnerParam(), posDaughterTrack.tpcNSigmaPr());
-    rLambda.fill(HIST("hNSigmaNegPionFromLambda"),  negDaughterTrack.tpcInnerParam(), negDaughterTrack.tpcNSigmaPi());
-       
-    if (0.3<posDaughterTrack.tpcInnerParam() && posDaughterTrack.tpcInnerParam()<4){
-      if(0.16<negDaughterTrack.tpcInnerParam() && negDaughterTrack.tpcInnerParam()<4){
-        
-        rLambda.fill(HIST("hPtLambda"), v0.pt());
-        rLambda.fill(HIST("hMassPtLambda"), v0.pt(), v0.mLambda());
-        float range=0.5;
-        if(v0.pt()>range && v0.pt()<range+0.125)
-          rLambda.fill(HIST("hMassLambdaPt1"), v0.mLambda());
-        range+=0.125;
-        if(v0.pt()>range && v0.pt()<range+0.125)
-          rLambda.fill(HIST("hMassLambdaPt2"), v0.mLambda());
-        range+=0.125;
-        if(v0.pt()>range && v0.pt()<range+0.125)
-          rLambda.fill(HIST("hMassLambdaPt3"), v0.mLambda());
-        range+=0.125;
-        if(v0.pt()>range && v0.pt()<range+0.125)
-          rLambda.fill(HIST("hMassLambdaPt4"), v0.mLambda());
-        range+=0.125;
-        if(v0.pt()>range && v0.pt()<range+0.125)
-          rLambda.fill(HIST("hMassLambdaPt5"), v0.mLambda());
-        range+=0.125;
-        if(v0.pt()>range && v0.pt()<range+0.125)
-          rLambda.fill(HIST("hMassLambdaPt6"), v0.mLambda());
-        range+=0.125;
-        if(v0.pt()>range && v0.pt()<range+0.125)
-          rLambda.fill(HIST("hMassLambdaPt7"), v0.mLambda());
-        range+=0.125;
-        if(v0.pt()>range && v0.pt()<range+0.125)
-          rLambda.fill(HIST("hMassLambdaPt8"), v0.mLambda());
-        range+=0.125;
-        if(v0.pt()>range && v0.pt()<range+0.125)
-          rLambda.fill(HIST("hMassLambdaPt9"), v0.mLambda());
-        range+=0.125;
-        if(v0.pt()>range && v0.pt()<range+0.125)
-          rLambda.fill(HIST("hMassLambdaPt10"), v0.mLambda());
-        range+=0.125;
-        if(v0.pt()>range && v0.pt()<range+0.125)
-          rLambda.fill(HIST("hMassLambdaPt11"), v0.mLambda());
-        range+=0.125;
-        if(v0.pt()>range && v0.pt()<range+0.125)
-          rLambda.fill(HIST("hMassLambdaPt12"), v0.mLambda());
-        range+=0.125;
-        if(v0.pt()>range && v0.pt()<range+0.125)
-          rLambda.fill(HIST("hMassLambdaPt13"), v0.mLambda());
-        range+=0.125;
-        if(v0.pt()>range && v0.pt()<range+0.125)
-          rLambda.fill(HIST("hMassLambdaPt14"), v0.mLambda());
-        range+=0.125;
-        if(v0.pt()>range && v0.pt()<range+0.125)
-          rLambda.fill(HIST("hMassLambdaPt15"), v0.mLambda());
-        range+=0.125;
-        if(v0.pt()>range && v0.pt()<range+0.125)
-          rLambda.fill(HIST("hMassLambdaPt16"), v0.mLambda());
-        
-   
-      }}}}};
+      const float ptLow = strangeness::lambdaPtLow + i * strangeness::lambdaPtWidth;
+      monitorFile << nTimeframes << "," << now << "," << ptLow << "," << ptLow + strangeness::lambdaPtWidth << ","
+                  << fit.status << "," << snapshot->GetEntries() << "," << fit.yield() << "," << fit.backgroundSum << ","
+                  << model->GetParameter(6) << "," << std::abs(model->GetParameter(7)) << "\n";
+    }
+    monitorFile.flush();
+  }
+
+  void processMonitor(aod::Collisions const&)
+  {
+    if (monitorEveryNTF <= 0 || ++nTimeframes % monitorEveryNTF != 0)
+      return;
+    fitMonitorSnapshots();
+  }
+  PROCESS_SWITCH(strangeness_tutorial, processMonitor, "Refit the mass histograms periodically and write yields to monitorOutput", false);
+};
 
 WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
 {
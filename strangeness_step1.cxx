@@ -7,6 +7,8 @@
 #include "Common/Core/TrackSelection.h"
 #include "Common/DataModel/TrackSelectionTables.h"
 
+#include "strangenessSelection.h"
+
 
 using namespace o2;
 using namespace o2::framework;
@@ -17,8 +19,6 @@ using namespace o2::framework::expressions;
 
 using CCs = soa::Join<aod::Collisions, aod::EvSels, aod::McCollisionLabels>;
 using CC = CCs::iterator;
-using TCs = soa::Join<aod::Tracks, aod::TracksExtra, aod::TrackSelection, aod::TrackSelectionExtension, aod::pidTPCMu, aod::McTrackLabels>;
-using TC = TCs::iterator;
 
 
 struct strangeness_tutorial {
@@ -41,14 +41,16 @@ struct strangeness_tutorial {
   Configurable<float> NSigmaTPCProton{"NSigmaTPCProton", 4, "NSigmaTPCProton"};
 
   TDatabasePDG* pdg = nullptr;
+  double massLambda = 0.;
+  strangeness::V0TopologyBuffer v0Topology;
   Preslice<aod::McParticles> partPerMcCollision = aod::mcparticle::mcCollisionId;
   PresliceUnsorted<CCs> colPerMcCollision = aod::mccollisionlabel::mcCollisionId;
-  PresliceUnsorted<TCs> trackPerMcParticle = aod::mctracklabel::mcParticleId;
 
   void init(InitContext const&)
   {
     
     pdg = TDatabasePDG::Instance();
+    massLambda = pdg->GetParticle(3122)->Mass();
     
     
     AxisSpec LambdaMassAxis = {100, 0.9f, 1.3f, "#it{M}_{inv} [GeV/#it{c}^{2}]"};
@@ -70,7 +72,8 @@ struct strangeness_tutorial {
   Filter preFilterV0 = (nabs(aod::v0data::dcapostopv) > v0setting_dcapostopv &&
                           nabs(aod::v0data::dcanegtopv) > v0setting_dcanegtopv &&
                           aod::v0data::dcaV0daughters < v0setting_dcav0dau);
-  using DaughterTracks = soa::Join<aod::TracksIU, aod::TracksExtra, aod::pidTPCPi, aod::pidTPCPr,aod::McTrackLabels>;
+  // all of TracksExtra is read for tpcInnerParam alone, see strangeness_step0
+  using DaughterTracks = soa::Join<aod::TracksIU, aod::TracksExtra, aod::pidTPCPi, aod::pidTPCPr>;
 
   void processReco(soa::Filtered<soa::Join<aod::Collisions, aod::EvSels>>::iterator const& collision,
                     soa::Filtered<soa::Join<aod::V0Datas, aod::McV0Labels>> const& V0s, aod::McParticles const& mcParticles,
@@ -80,14 +83,19 @@ struct strangeness_tutorial {
     
     rEventSelection.fill(HIST("hVertexZRec"), collision.posZ());
 
+    v0Topology.clear();
+    for (const auto& v0 : V0s) {
+      v0Topology.push(v0.x(), v0.y(), v0.z(), v0.px(), v0.py(), v0.pz());
+    }
+    v0Topology.select(collision.posX(), collision.posY(), collision.posZ(), v0setting_cospa, v0setting_radius);
+
+    int iV0 = 0;
     for (const auto& v0 : V0s) {
+    if (!v0Topology.selected[iV0++])
+      continue;
     const auto& posDaughterTrack = v0.posTrack_as<DaughterTracks>();
     const auto& negDaughterTrack = v0.negTrack_as<DaughterTracks>();
     
-    if (v0.v0cosPA(collision.posX(), collision.posY(), collision.posZ()) < v0setting_cospa)
-      continue;
-    if (v0.v0radius() < v0setting_radius)
-      continue;
     if (TMath::Abs(posDaughterTrack.tpcNSigmaPr()) > NSigmaTPCProton) {
     continue;
     }
@@ -102,7 +110,6 @@ struct strangeness_tutorial {
           if(v0.pt()>0.5 && v0.pt()<2.0){
             if(v0.eta()>-0.8 && v0.eta()<0.8){
               rLambdaReco.fill(HIST("hMassLambda"), v0.mLambda());
-              std::cout<<"processReco";
               rLambdaReco.fill(HIST("hPtLambda"), v0.pt());
             }}}}}}};
 
@@ -110,7 +117,7 @@ struct strangeness_tutorial {
 
     
   void processTruth(aod::McCollisions const& mccollisions, CCs const& collisions,
-    aod::McParticles const& McParts, TCs const& tracks){
+    aod::McParticles const& McParts){
     
     // loop over all genererated collisions
     for (auto mccollision : mccollisions) {
@@ -118,8 +125,7 @@ struct strangeness_tutorial {
     // get McParticles which belong to mccollision
       auto partSlice = McParts.sliceBy(partPerMcCollision, mccollision.globalIndex());
       for (auto McPart : partSlice) {
-   
-          TParticlePDG* lambda = pdg->GetParticle(3122);
+
           if(McPart.has_daughters()){
             if (McPart.pdgCode() == 3122) {
               
@@ -127,7 +133,7 @@ struct strangeness_tutorial {
                 if(McPart.pt()>0.5 && McPart.pt()<2.0){
                   if(McPart.eta()>-0.8 && McPart.eta()<0.8){
                     rLambdaTruth.fill(HIST("hPtLambda"), McPart.pt());
-                    rLambdaTruth.fill(HIST("hMassLambda"), lambda->Mass());}}}}}
+                    rLambdaTruth.fill(HIST("hMassLambda"), massLambda);}}}}}
     }}};
     PROCESS_SWITCH(strangeness_tutorial, processTruth, "Process MC truth data", true);
   };